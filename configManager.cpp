@@ -62,6 +62,7 @@ bool ConfigManager::loadConfig(DeviceConfig& config) {
     strlcpy(config.mqttHost, doc["mqttHost"] | "", sizeof(config.mqttHost));
     config.mqttPort = doc["mqttPort"] | 8883;
     strlcpy(config.mqttClientId, doc["mqttClientId"] | "", sizeof(config.mqttClientId));
+    strlcpy(config.mqttGroup, doc["mqttGroup"] | "", sizeof(config.mqttGroup));
 
     strlcpy(config.mqttCaCert, doc["mqttCaCert"] | "", sizeof(config.mqttCaCert));
     strlcpy(config.mqttClientCert, doc["mqttClientCert"] | "", sizeof(config.mqttClientCert));
@@ -89,6 +90,7 @@ bool ConfigManager::saveConfig(const DeviceConfig& config) {
 
     doc["mqttHost"] = config.mqttHost;
     doc["mqttClientId"] = config.mqttClientId;
+    doc["mqttGroup"] = config.mqttGroup;
     doc["mqttPort"] = config.mqttPort;
 
     doc["mqttClientCert"] = config.mqttClientCert;
@@ -125,4 +127,8 @@ bool ConfigManager::clearConfig() {
 
 bool ConfigManager::configExists() {
     return LittleFS.exists(CONFIG_FILE);
+}
+
+bool ConfigManager::isValidTopicLevel(const char* level) {
+    return strlen(level) > 0 && strpbrk(level, "/+#") == nullptr;
 }
\ No newline at end of file
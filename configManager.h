@@ -13,6 +13,7 @@ struct DeviceConfig {
     char mqttHost[128];
     int mqttPort;
     char mqttClientId[64];
+    char mqttGroup[32];
 
     char mqttCaCert[4096];
     char mqttClientCert[2048];
@@ -26,6 +27,7 @@ struct DeviceConfig {
 
         memset(mqttHost, 0, sizeof(mqttHost));
         memset(mqttClientId, 0, sizeof(mqttClientId));
+        memset(mqttGroup, 0, sizeof(mqttGroup));
 
         memset(mqttCaCert, 0, sizeof(mqttCaCert));
         memset(mqttClientCert, 0, sizeof(mqttClientCert));
@@ -45,6 +47,9 @@ public:
     static bool clearConfig();
 
     static bool configExists();
+
+    // True for a non-empty MQTT topic level without '/', '+' or '#'
+    static bool isValidTopicLevel(const char* level);
 };
 
 #endif
\ No newline at end of file
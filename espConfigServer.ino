@@ -3,6 +3,8 @@
 #include "ConfigManager.h"
 #include "MqttManager.h"
 #include "ledManager.h"
+#include "taskScheduler.h"
+#include "topicRouter.h"
 
 #define RESET_PIN 4
 
@@ -11,6 +13,9 @@ WebServerHandler *webServerHandlerPtr;
 MQTTManager *mqttManagerPtr;
 DeviceConfig deviceConfig;
 
+TaskScheduler scheduler;
+TopicRouter topicRouter;
+
 bool inConfigMode = false;
 
 
@@ -19,12 +24,77 @@ void mqttCallback(char* topic, byte* payload, unsigned int msg_length){
   Serial.print(topic);
   Serial.println("]");
   
-  if(msg_length <= 128) { 
-    LEDManager::parsePayload(payload, msg_length); 
+  if(topicRouter.dispatch(topic, payload, msg_length) == 0) {
+    Serial.println("MQTTManager: No route for topic.");
   }
   
 }
 
+void handleLedCommand(char* topic, byte* payload, unsigned int msg_length){
+  if(msg_length > 128) {
+    return;
+  }
+
+  StaticJsonDocument<256> cmdPayload;
+  if (deserializeJson(cmdPayload, payload, msg_length)) {
+    Serial.println("MQTTManager: Malformed command payload.");
+    return;
+  }
+
+  mqttManagerPtr->applyCommandOnce(cmdPayload["id"] | 0UL, [&cmdPayload](){
+    return LEDManager::handleCommand(cmdPayload);
+  });
+}
+
+// Subscribes to a topic and routes its messages to the handler
+void subscribeRoute(const char* filter, TopicHandler handler){
+  if(topicRouter.add(filter, handler)){
+    mqttManagerPtr->subscribe(filter);
+  }
+}
+
+void checkResetPin(){
+  if (digitalRead(RESET_PIN) == LOW) {
+    if(ConfigManager::clearConfig()) {
+      delay(1000);
+      ESP.restart();
+    }
+  }
+}
+
+void checkWiFi(){
+  if (!wiFiManagerPtr->isConnected()) {
+    Serial.println("Loop: Wi-Fi lost. Attempting to reconnect...");
+    if (!wiFiManagerPtr->connectWiFi()) {
+      Serial.println("Loop: Failed to reconnect Wi-Fi. Restarting to re-enter config mode.");
+      digitalWrite(LED_BUILTIN, LOW); // Turn LED on to indicate WiFi loss
+      delay(5000); // Wait a bit
+      ESP.restart(); // Restart to fall back to config mode
+    }
+  }
+}
+
+void setupTasks(){
+  // Frame rendering has deadline priority over everything else
+  scheduler.addDeadlineTask("led", [](){ LEDManager::renderFrame(); }, LED_FRAME_MS, 2000);
+  scheduler.addTask("reset", checkResetPin, 50, 200, 500);
+  // Per-task run/overrun counters are only visible through this report;
+  // one line every 10 s keeps each write inside the UART TX FIFO
+  scheduler.addTask("stats", [](){ scheduler.printNextStats(Serial); }, 10000, 0, 0);
+
+  if(inConfigMode){
+    scheduler.addTask("web", [](){ webServerHandlerPtr->handleClient(); }, 5, 100, 5000);
+    scheduler.addTask("dns", [](){ wiFiManagerPtr->handleDNS(); }, 5, 100, 2000);
+  }else{
+    scheduler.addTask("wifi", checkWiFi, 1000, 150, 1000);
+    scheduler.addTask("mqtt", [](){
+      if (wiFiManagerPtr->isConnected()) {
+        mqttManagerPtr->loop();
+      }
+    }, 10, 100, 10000);
+  }
+}
+
 void setup()
 {
 
@@ -68,13 +138,19 @@ void setup()
 
       LEDManager::setRGBStatus(0,0,255);
 
+      // Registered up front so a later reconnect from loop() restores them too
+      subscribeRoute(MQTT_FLEET_COMMAND_TOPIC, handleLedCommand);
+      subscribeRoute(mqttManagerPtr->getDeviceTopic(), handleLedCommand);
+      if (strlen(mqttManagerPtr->getGroupTopic()) > 0) {
+        subscribeRoute(mqttManagerPtr->getGroupTopic(), handleLedCommand);
+      }
+
       if (wiFiManagerPtr->connectWiFi()) {
         mqttManagerPtr->begin();
 
         if (mqttManagerPtr->connectMQTT()) {
           LEDManager::setRGBStatus(0,255,0);
           Serial.println("Setup: MQTT Connected. Ready to operate!");
-          mqttManagerPtr->subscribe("lightbox/command");
         } else {
           LEDManager::setRGBStatus(255,0,30);
           Serial.println("Setup: Failed to connect to MQTT. Check credentials/broker.");
@@ -87,39 +163,10 @@ void setup()
 
   }
 
+  setupTasks();
+
 }
 
 void loop(){
-
-  if (digitalRead(RESET_PIN) == LOW) {
-    if(ConfigManager::clearConfig()) {
-      delay(1000);
-      ESP.restart();
-    }
-  }
-  
-  if(inConfigMode){
-
-    webServerHandlerPtr->handleClient();
-    wiFiManagerPtr->handleDNS();
-
-  }else{
-
-    if (!wiFiManagerPtr->isConnected()) {
-      Serial.println("Loop: Wi-Fi lost. Attempting to reconnect...");
-      if (!wiFiManagerPtr->connectWiFi()) {
-        Serial.println("Loop: Failed to reconnect Wi-Fi. Restarting to re-enter config mode.");
-        digitalWrite(LED_BUILTIN, LOW); // Turn LED on to indicate WiFi loss
-        delay(5000); // Wait a bit
-        ESP.restart(); // Restart to fall back to config mode
-      }
-    }
-
-
-    if (wiFiManagerPtr->isConnected()) {
-      mqttManagerPtr->loop();
-    }
-
-  }
-
+  scheduler.run();
 }
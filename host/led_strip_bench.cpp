@@ -0,0 +1,85 @@
+// Per-frame cost of FixedLedStrip against the Adafruit_NeoPixel path
+// LEDManager used before (setPixelColor(i, Color(r, g, b)) per pixel)
+
+#include "ledStrip.h"
+
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static uint64_t cycles() { return __rdtsc(); }
+#define CYCLE_UNIT "cycles"
+#else
+static uint64_t cycles() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#define CYCLE_UNIT "ns"
+#endif
+
+#define FRAMES 200000
+
+// Same strip as ledManager.h, which is not included to keep ArduinoJson out
+#define LED_PIN    5
+#define LED_COUNT 30
+#define LED_COLOR_ORDER ColorOrder::GRB
+#define LED_DEFAULT_BRIGHTNESS 50
+
+// Keeps the compiler from dropping frames nobody reads
+static void clobber(const void* p) { asm volatile("" : : "r"(p) : "memory"); }
+
+static Adafruit_NeoPixel adafruitStrip(LED_COUNT, LED_PIN, NEO_GRB + NEO_KHZ800);
+static FixedLedStrip<LED_COUNT, LED_PIN, LED_COLOR_ORDER, LED_DEFAULT_BRIGHTNESS> fixedStrip;
+
+static void adafruitSolid(uint8_t v) {
+    for (int i = 0; i < LED_COUNT; i++) {
+        adafruitStrip.setPixelColor(i, adafruitStrip.Color(v, 255 - v, v / 2));
+    }
+    clobber(adafruitStrip.getPixels());
+}
+
+static void fixedSolid(uint8_t v) {
+    fixedStrip.fill(v, 255 - v, v / 2);
+    clobber(&fixedStrip);
+}
+
+static void adafruitPerPixel(uint8_t v) {
+    for (int i = 0; i < LED_COUNT; i++) {
+        adafruitStrip.setPixelColor(i, adafruitStrip.Color(v + i, 255 - v - i, v ^ i));
+    }
+    clobber(adafruitStrip.getPixels());
+}
+
+static void fixedPerPixel(uint8_t v) {
+    for (int i = 0; i < LED_COUNT; i++) {
+        fixedStrip.setPixel(i, v + i, 255 - v - i, v ^ i);
+    }
+    clobber(&fixedStrip);
+}
+
+static double perFrame(void (*frame)(uint8_t)) {
+    for (int f = 0; f < 1000; f++) {
+        frame((uint8_t)f);
+    }
+
+    uint64_t start = cycles();
+    for (int f = 0; f < FRAMES; f++) {
+        frame((uint8_t)f);
+    }
+    return (double)(cycles() - start) / FRAMES;
+}
+
+static void report(const char* name, double adafruit, double fixed) {
+    printf("%-16s %10.1f %10.1f %8.2fx\n", name, adafruit, fixed, adafruit / fixed);
+}
+
+int main() {
+    adafruitStrip.begin();
+    adafruitStrip.setBrightness(LED_DEFAULT_BRIGHTNESS);
+    fixedStrip.begin();
+
+    printf("%d-pixel frame, %s per frame (lower is better)\n", LED_COUNT, CYCLE_UNIT);
+    printf("%-16s %10s %10s %9s\n", "frame", "adafruit", "fixed", "speedup");
+    report("solid fill", perFrame(adafruitSolid), perFrame(fixedSolid));
+    report("per-pixel", perFrame(adafruitPerPixel), perFrame(fixedPerPixel));
+    return 0;
+}
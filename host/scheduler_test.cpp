@@ -0,0 +1,185 @@
+// Fake-clock tests for TaskScheduler
+
+#include "taskScheduler.h"
+
+#include <climits>
+
+static unsigned long fakeNow = 0;
+static unsigned long fakeClock() { return fakeNow; }
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+    do {                                                              \
+        if (!(cond)) {                                                \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+            failures++;                                               \
+        }                                                             \
+    } while (0)
+
+static char order[8];
+static int orderCount = 0;
+
+static void runA() { order[orderCount++] = 'a'; }
+static void runB() { order[orderCount++] = 'b'; }
+static void runD() { order[orderCount++] = 'd'; }
+static void runSlow() { order[orderCount++] = 's'; fakeNow += 3000; }
+
+// Collects printNextStats() output so the counters can be checked
+class CapturePrint : public Print {
+public:
+    char text[256];
+    size_t length = 0;
+
+    CapturePrint() { text[0] = '\0'; }
+
+    void write(const char* value) override {
+        size_t n = strlen(value);
+        if (length + n < sizeof(text)) {
+            memcpy(text + length, value, n + 1);
+            length += n;
+        }
+    }
+};
+
+static void resetOrder() {
+    orderCount = 0;
+    memset(order, 0, sizeof(order));
+}
+
+static void testFirstRunAfterOnePeriod() {
+    fakeNow = 0;
+    resetOrder();
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask("a", runA, 10, 1, 0);
+
+    scheduler.run();
+    CHECK(orderCount == 0);
+
+    fakeNow = 9999;
+    scheduler.run();
+    CHECK(orderCount == 0);
+
+    fakeNow = 10000;
+    scheduler.run();
+    CHECK(orderCount == 1);
+}
+
+static void testDeadlineBeforePriority() {
+    fakeNow = 0;
+    resetOrder();
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask("a", runA, 10, 1, 0);
+    scheduler.addTask("b", runB, 10, 200, 0);
+    scheduler.addDeadlineTask("d", runD, 10, 0);
+
+    fakeNow = 10000;
+    scheduler.run();
+    CHECK(strcmp(order, "dba") == 0);
+
+    // Stats cycle through the tasks one line per call
+    CapturePrint stats;
+    scheduler.printNextStats(stats);
+    scheduler.printNextStats(stats);
+    scheduler.printNextStats(stats);
+    scheduler.printNextStats(stats);
+    CHECK(strncmp(stats.text, "TaskScheduler: a ", 17) == 0);
+    CHECK(strstr(stats.text, "\nTaskScheduler: d ") != nullptr);
+    CHECK(strstr(stats.text, "\nTaskScheduler: a ") != nullptr);
+}
+
+static void testEachTaskOncePerPass() {
+    fakeNow = 0;
+    resetOrder();
+    TaskScheduler scheduler(fakeClock);
+    // A zero period keeps the task permanently due
+    scheduler.addTask("a", runA, 0, 1, 0);
+
+    scheduler.run();
+    CHECK(orderCount == 1);
+    scheduler.run();
+    CHECK(orderCount == 2);
+}
+
+static void testOverrunsAndMissed() {
+    fakeNow = 0;
+    resetOrder();
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask("s", runSlow, 1, 1, 2000);
+
+    // Due at 1 ms, takes 3 ms: over budget, and the 2, 3 and 4 ms slots are
+    // gone by the time it finishes at 4 ms
+    fakeNow = 1000;
+    scheduler.run();
+    CHECK(orderCount == 1);
+
+    CapturePrint stats;
+    scheduler.printNextStats(stats);
+    CHECK(strcmp(stats.text, "TaskScheduler: s runs=1 overruns=1 missed=3 maxUs=3000\n") == 0);
+
+    // Rescheduled one period after the late finish, not run back to back
+    fakeNow = 4999;
+    scheduler.run();
+    CHECK(orderCount == 1);
+    fakeNow = 5000;
+    scheduler.run();
+    CHECK(orderCount == 2);
+}
+
+static void testMissedCounter() {
+    fakeNow = 0;
+    resetOrder();
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask("a", runA, 10, 1, 0);
+
+    // Due at 10 ms but first polled at 45 ms: the 20, 30 and 40 ms slots are missed
+    fakeNow = 45000;
+    scheduler.run();
+    CHECK(orderCount == 1);
+
+    CapturePrint stats;
+    scheduler.printNextStats(stats);
+    CHECK(strcmp(stats.text, "TaskScheduler: a runs=1 overruns=0 missed=3 maxUs=0\n") == 0);
+
+    fakeNow = 54999;
+    scheduler.run();
+    CHECK(orderCount == 1);
+    fakeNow = 55000;
+    scheduler.run();
+    CHECK(orderCount == 2);
+}
+
+static void testClockRollover() {
+    fakeNow = ULONG_MAX - 4999;
+    resetOrder();
+    TaskScheduler scheduler(fakeClock);
+    scheduler.addTask("a", runA, 10, 1, 0);
+
+    // nextRunUs has wrapped past zero, an unsigned compare would fire at once
+    scheduler.run();
+    CHECK(orderCount == 0);
+
+    fakeNow = ULONG_MAX;
+    scheduler.run();
+    CHECK(orderCount == 0);
+
+    fakeNow = 5000;
+    scheduler.run();
+    CHECK(orderCount == 1);
+}
+
+int main() {
+    testFirstRunAfterOnePeriod();
+    testDeadlineBeforePriority();
+    testEachTaskOncePerPass();
+    testOverrunsAndMissed();
+    testMissedCounter();
+    testClockRollover();
+
+    if (failures > 0) {
+        printf("scheduler_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("scheduler_test: all tests passed\n");
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include "Adafruit_NeoPixel.h"
+
+#include <cstdlib>
+
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, int16_t pin, neoPixelType type)
+    : numLEDs(n), brightness(0) {
+    (void)pin;
+    wOffset = (type >> 6) & 0b11;
+    rOffset = (type >> 4) & 0b11;
+    gOffset = (type >> 2) & 0b11;
+    bOffset = type & 0b11;
+    pixels = (uint8_t*)calloc(n, (wOffset == rOffset) ? 3 : 4);
+}
+
+Adafruit_NeoPixel::~Adafruit_NeoPixel() {
+    free(pixels);
+}
+
+void Adafruit_NeoPixel::setPixelColor(uint16_t n, uint32_t c) {
+    if (n < numLEDs) {
+        uint8_t* p;
+        uint8_t r = (uint8_t)(c >> 16), g = (uint8_t)(c >> 8), b = (uint8_t)c;
+        if (brightness) {
+            r = (r * brightness) >> 8;
+            g = (g * brightness) >> 8;
+            b = (b * brightness) >> 8;
+        }
+        if (wOffset == rOffset) {
+            p = &pixels[n * 3];
+        } else {
+            p = &pixels[n * 4];
+            uint8_t w = (uint8_t)(c >> 24);
+            p[wOffset] = brightness ? ((w * brightness) >> 8) : w;
+        }
+        p[rOffset] = r;
+        p[gOffset] = g;
+        p[bOffset] = b;
+    }
+}
+
+void Adafruit_NeoPixel::setBrightness(uint8_t b) {
+    // Stored off by one like the library, 0 means no scaling
+    brightness = b + 1;
+}
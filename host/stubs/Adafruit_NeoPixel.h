@@ -0,0 +1,45 @@
+#ifndef HOST_ADAFRUIT_NEOPIXEL_H
+#define HOST_ADAFRUIT_NEOPIXEL_H
+
+// Host stand-in for Adafruit_NeoPixel. setPixelColor() follows the library's
+// per-pixel path (bounds check, brightness scaling, offset lookup) and lives
+// in its own translation unit like the real one, so benchmarks compare
+// against what the firmware used to run. show() does nothing.
+
+#include "Arduino.h"
+
+typedef uint16_t neoPixelType;
+
+#define NEO_RGB ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_RBG ((0 << 6) | (0 << 4) | (2 << 2) | (1))
+#define NEO_GRB ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_GBR ((2 << 6) | (2 << 4) | (0 << 2) | (1))
+#define NEO_BRG ((1 << 6) | (1 << 4) | (2 << 2) | (0))
+#define NEO_BGR ((2 << 6) | (2 << 4) | (1 << 2) | (0))
+
+#define NEO_KHZ800 0x0000
+
+class Adafruit_NeoPixel {
+public:
+    Adafruit_NeoPixel(uint16_t n, int16_t pin, neoPixelType type);
+    ~Adafruit_NeoPixel();
+
+    void begin() {}
+    void show() {}
+
+    void setPixelColor(uint16_t n, uint32_t c);
+    void setBrightness(uint8_t b);
+    uint8_t* getPixels() const { return pixels; }
+
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
+private:
+    uint16_t numLEDs;
+    uint8_t brightness;
+    uint8_t* pixels;
+    uint8_t rOffset, gOffset, bOffset, wOffset;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#include "Arduino.h"
+
+#include <chrono>
+#include <thread>
+
+Print Serial;
+
+static const auto start = std::chrono::steady_clock::now();
+
+unsigned long micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long millis() {
+    return micros() / 1000;
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
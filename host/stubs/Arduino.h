@@ -0,0 +1,45 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal Arduino core for building firmware modules on the host
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+typedef uint8_t byte;
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+
+using std::min;
+using std::max;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual void write(const char* text) { fputs(text, stdout); }
+
+    void print(const char* value) { write(value); }
+    void print(char value) { char text[2] = {value, '\0'}; write(text); }
+    void print(int value) { print((long)value); }
+    void print(unsigned int value) { print((unsigned long)value); }
+    void print(long value) { char text[24]; snprintf(text, sizeof(text), "%ld", value); write(text); }
+    void print(unsigned long value) { char text[24]; snprintf(text, sizeof(text), "%lu", value); write(text); }
+
+    template <typename T>
+    void println(T value) {
+        print(value);
+        println();
+    }
+    void println() { write("\n"); }
+};
+
+extern Print Serial;
+
+#endif
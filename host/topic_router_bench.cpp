@@ -0,0 +1,62 @@
+// Dispatch cost of TopicRouter with a realistic table of ~50 routes
+
+#include "topicRouter.h"
+
+#include <chrono>
+
+#define DEVICE_ROUTES 45
+#define ITERATIONS 1000000
+
+static volatile unsigned long handled = 0;
+
+static void handler(char*, byte*, unsigned int) { handled = handled + 1; }
+
+static double perDispatch(TopicRouter& router, const char* topic) {
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "%s", topic);
+
+    for (int i = 0; i < 1000; i++) {
+        router.dispatch(buffer, nullptr, 0);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        router.dispatch(buffer, nullptr, 0);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / ITERATIONS;
+}
+
+int main() {
+    TopicRouter router;
+    char filter[32];
+    int routes = 0;
+
+    for (int i = 0; i < DEVICE_ROUTES; i++) {
+        snprintf(filter, sizeof(filter), "lightbox/dev%02d/command", i);
+        routes += router.add(filter, handler);
+    }
+    routes += router.add("lightbox/command", handler);
+    routes += router.add("lightbox/group/+/command", handler);
+    routes += router.add("lightbox/+/config", handler);
+    routes += router.add("lightbox/ota/#", handler);
+    routes += router.add("lightbox/frames/+", handler);
+
+    printf("%d routes, ns per dispatch (lower is better)\n", routes);
+
+    // Siblings are prepended, so dev00 sits at the end of its list
+    const char* topics[] = {
+        "lightbox/command",
+        "lightbox/dev44/command",
+        "lightbox/dev00/command",
+        "lightbox/group/kitchen/command",
+        "lightbox/ota/image/chunk",
+        "lightbox/unknown/status",
+        "other/topic",
+    };
+
+    for (const char* topic : topics) {
+        printf("%-32s %8.1f\n", topic, perDispatch(router, topic));
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+// Matching, capacity and rollback tests for TopicRouter
+
+#include "topicRouter.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                   \
+    do {                                                              \
+        if (!(cond)) {                                                \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+            failures++;                                               \
+        }                                                             \
+    } while (0)
+
+static int hits[4];
+
+static void handler0(char*, byte*, unsigned int) { hits[0]++; }
+static void handler1(char*, byte*, unsigned int) { hits[1]++; }
+static void handler2(char*, byte*, unsigned int) { hits[2]++; }
+static void handler3(char*, byte*, unsigned int) { hits[3]++; }
+
+// dispatch() takes a mutable topic like PubSubClient hands out
+static uint8_t dispatch(TopicRouter& router, const char* topic) {
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "%s", topic);
+    return router.dispatch(buffer, nullptr, 0);
+}
+
+static void testMatching() {
+    TopicRouter router;
+    memset(hits, 0, sizeof(hits));
+
+    CHECK(router.add("lightbox/command", handler0));
+    CHECK(router.add("lightbox/+/command", handler1));
+    CHECK(router.add("lightbox/ota/#", handler2));
+    CHECK(router.add("#", handler3));
+
+    CHECK(dispatch(router, "lightbox/command") == 2);
+    CHECK(dispatch(router, "lightbox/dev1/command") == 2);
+    CHECK(dispatch(router, "lightbox/dev1/status") == 1);
+    CHECK(hits[0] == 1 && hits[1] == 1 && hits[3] == 3);
+
+    // "a/#" also matches "a"
+    CHECK(dispatch(router, "lightbox/ota") == 2);
+    CHECK(dispatch(router, "lightbox/ota/x/y") == 2);
+    CHECK(hits[2] == 2);
+
+    // First-level wildcards skip $-prefixed system topics
+    CHECK(dispatch(router, "$SYS/broker/load") == 0);
+}
+
+static void testInvalidFilters() {
+    TopicRouter router;
+
+    CHECK(!router.add("", handler0));
+    CHECK(!router.add("a/#/b", handler0));
+    CHECK(!router.add("a/b+", handler0));
+    CHECK(!router.add("a/#b", handler0));
+    CHECK(!router.add("a/b", nullptr));
+
+    CHECK(router.add("a/b", handler0));
+    CHECK(!router.add("a/b", handler1));
+}
+
+static void testCapacity() {
+    TopicRouter router;
+    memset(hits, 0, sizeof(hits));
+    char filter[32];
+
+    // Documented capacity: about 60 "lightbox/<id>/cmd" routes
+    int added = 0;
+    for (int i = 0; i < 60; i++) {
+        snprintf(filter, sizeof(filter), "lightbox/dev%02d/cmd", i);
+        added += router.add(filter, handler0);
+    }
+    CHECK(added == 60);
+
+    for (int i = 0; i < 60; i++) {
+        snprintf(filter, sizeof(filter), "lightbox/dev%02d/cmd", i);
+        CHECK(dispatch(router, filter) == 1);
+    }
+    CHECK(hits[0] == 60);
+}
+
+static void testRollback() {
+    TopicRouter router;
+    memset(hits, 0, sizeof(hits));
+    char filter[32];
+
+    // Root plus 120 single-level routes leaves 7 free nodes
+    for (int i = 0; i < 120; i++) {
+        snprintf(filter, sizeof(filter), "r%03d", i);
+        CHECK(router.add(filter, handler0));
+    }
+
+    // Needs 8 nodes: fails after creating 7, which must all be released
+    CHECK(!router.add("f/1/2/3/4/5/6/7", handler1));
+    CHECK(dispatch(router, "f/1/2/3/4/5/6/7") == 0);
+
+    // Needs exactly the 7 nodes the failed add would otherwise have kept
+    CHECK(router.add("g/1/2/3/4/5/6", handler2));
+    CHECK(dispatch(router, "g/1/2/3/4/5/6") == 1);
+    CHECK(!router.add("h", handler3));
+
+    // A failed wildcard route is unlinked from its parent too
+    TopicRouter wildcard;
+    for (int i = 0; i < 126; i++) {
+        snprintf(filter, sizeof(filter), "r%03d", i);
+        wildcard.add(filter, handler0);
+    }
+    CHECK(!wildcard.add("+/x", handler1));
+    CHECK(dispatch(wildcard, "zzz/x") == 0);
+    // The freed node is reused; a stale '+' link would now point at "s"
+    CHECK(wildcard.add("s", handler2));
+    CHECK(dispatch(wildcard, "s") == 1);
+    CHECK(dispatch(wildcard, "zzz") == 0);
+
+    // Existing routes survive both rollbacks
+    CHECK(dispatch(router, "r000") == 1);
+    CHECK(dispatch(wildcard, "r125") == 1);
+}
+
+int main() {
+    testMatching();
+    testInvalidFilters();
+    testCapacity();
+    testRollback();
+
+    if (failures > 0) {
+        printf("topic_router_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("topic_router_test: all tests passed\n");
+    return 0;
+}
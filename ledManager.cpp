@@ -1,53 +1,156 @@
 #include "ledManager.h"
 
-Adafruit_NeoPixel strip(LED_COUNT, LED_PIN, NEO_GRB + NEO_KHZ800);
+#define TRANSITION_STEPS 1024
+
+FixedLedStrip<LED_COUNT, LED_PIN, LED_COLOR_ORDER, LED_DEFAULT_BRIGHTNESS> strip;
 
 unsigned char LEDManager::_r = 255;
 unsigned char LEDManager::_g = 0;
 unsigned char LEDManager::_b = 0;
+unsigned char LEDManager::_pixels[LED_COUNT][3] = {{0}};
+unsigned char LEDManager::_from[LED_COUNT][3] = {{0}};
+bool LEDManager::_pixelsUniform = true;
+bool LEDManager::_fromUniform = true;
 unsigned char LEDManager::_transitionType = 1;
+unsigned char LEDManager::_activeType = 1;
+unsigned char LEDManager::_easing = EASE_IN_OUT;
+unsigned long LEDManager::_transitionMs = LED_DEFAULT_TRANSITION_MS;
+unsigned long LEDManager::_activeMs = 0;
+unsigned char LEDManager::_activeEasing = EASE_LINEAR;
+unsigned long LEDManager::_transitionStart = 0;
+bool LEDManager::_transitionActive = false;
+bool LEDManager::_frameDirty = false;
 
 void LEDManager::begin()
 {
     strip.begin();
     strip.show();
-    strip.setBrightness(50);
-    _colorChase(strip.Color(_r, _b, _g), 50);
+    _startTransition(_r, _g, _b, 2, LED_COUNT * 50, EASE_LINEAR);
+    _waitForTransition();
+}
+
+unsigned int LEDManager::_ease(unsigned int p, unsigned char easing)
+{
+    switch (easing)
+    {
+    case EASE_IN:
+        return p * p / TRANSITION_STEPS;
+    case EASE_OUT:
+        return TRANSITION_STEPS - (TRANSITION_STEPS - p) * (TRANSITION_STEPS - p) / TRANSITION_STEPS;
+    case EASE_IN_OUT: // smoothstep
+        return p * p / TRANSITION_STEPS * (3 * TRANSITION_STEPS - 2 * p) / TRANSITION_STEPS;
+    default:
+        return p;
+    }
 }
 
-void LEDManager::_fadeColor(unsigned char r, unsigned char g, unsigned char b)
+unsigned char LEDManager::_mix(unsigned char from, unsigned char to, unsigned int p)
 {
+    return from + ((int)to - (int)from) * (int)p / TRANSITION_STEPS;
+}
 
-    for (int brightness = 255; brightness >= 0; brightness--)
+void LEDManager::_showColor(unsigned char red, unsigned char green, unsigned char blue)
+{
+    strip.fill(red, green, blue);
+    for (unsigned int i = 0; i < LED_COUNT; i++)
     {
-        for (int i = 0; i < LED_COUNT; i++)
-        {
-            strip.setPixelColor(i, strip.Color(_r * brightness / 255, _g * brightness / 255, _b * brightness / 255));
-        }
-        strip.show();
-        delay(5);
+        _pixels[i][0] = red;
+        _pixels[i][1] = green;
+        _pixels[i][2] = blue;
+    }
+    _pixelsUniform = true;
+}
+
+void LEDManager::_showPixel(unsigned int index, unsigned char red, unsigned char green, unsigned char blue)
+{
+    strip.setPixel(index, red, green, blue);
+    _pixels[index][0] = red;
+    _pixels[index][1] = green;
+    _pixels[index][2] = blue;
+    _pixelsUniform = false;
+}
+
+void LEDManager::_startTransition(unsigned char red, unsigned char green, unsigned char blue,
+                                  unsigned char type, unsigned long durationMs, unsigned char easing)
+{
+    // Start every pixel from what the last frame showed so an interrupted
+    // transition (including a half-finished chase) carries on without jumping
+    memcpy(_from, _pixels, sizeof(_from));
+    _fromUniform = _pixelsUniform;
+
+    _r = red;
+    _g = green;
+    _b = blue;
+
+    if (durationMs == 0)
+    {
+        _transitionActive = false;
+        _showColor(red, green, blue);
+        _frameDirty = true;
+        return;
     }
 
-    delay(100);
+    _activeType = type;
+    _activeMs = durationMs;
+    _activeEasing = easing;
+    _transitionStart = millis();
+    _transitionActive = true;
+}
 
-    for (int brightness = 0; brightness <= 255; brightness++)
+void LEDManager::_drawFrame(unsigned long now)
+{
+    unsigned long elapsed = now - _transitionStart;
+
+    if (elapsed >= _activeMs)
     {
-        for (int i = 0; i < LED_COUNT; i++)
+        _transitionActive = false;
+        _showColor(_r, _g, _b);
+        return;
+    }
+
+    unsigned int p = _ease(elapsed * TRANSITION_STEPS / _activeMs, _activeEasing);
+
+    switch (_activeType)
+    {
+    case 2: // chasing transition
+    {
+        unsigned int lit = p * LED_COUNT / TRANSITION_STEPS;
+        for (unsigned int i = 0; i < LED_COUNT; i++)
+        {
+            if (i < lit)
+            {
+                _showPixel(i, _r, _g, _b);
+            }
+            else
+            {
+                _showPixel(i, _from[i][0], _from[i][1], _from[i][2]);
+            }
+        }
+        break;
+    }
+    default: // fade transition
+        if (_fromUniform)
+        {
+            _showColor(_mix(_from[0][0], _r, p), _mix(_from[0][1], _g, p), _mix(_from[0][2], _b, p));
+        }
+        else
         {
-            strip.setPixelColor(i, strip.Color(r * brightness / 255, g * brightness / 255, b * brightness / 255));
+            for (unsigned int i = 0; i < LED_COUNT; i++)
+            {
+                _showPixel(i, _mix(_from[i][0], _r, p), _mix(_from[i][1], _g, p), _mix(_from[i][2], _b, p));
+            }
         }
-        strip.show();
-        delay(5);
+        break;
     }
 }
 
-void LEDManager::_colorChase(uint32_t color, int wait)
+void LEDManager::_waitForTransition()
 {
-    for (int i = 0; i < LED_COUNT; i++)
+    renderFrame();
+    while (_transitionActive)
     {
-        strip.setPixelColor(i, color);
-        strip.show();
-        delay(wait);
+        delay(LED_FRAME_MS);
+        renderFrame();
     }
 }
 
@@ -60,59 +163,81 @@ void LEDManager::_setBrightness(unsigned int brightness)
 
     strip.setBrightness(newBrightness);
 
-    for (int i = 0; i < LED_COUNT; i++)
+    // A running transition repaints the whole strip on its next frame
+    if (!_transitionActive && _pixelsUniform)
+    {
+        strip.fill(_pixels[0][0], _pixels[0][1], _pixels[0][2]);
+    }
+    else if (!_transitionActive)
     {
-        strip.setPixelColor(i, strip.Color(_r, _g, _b));
+        for (unsigned int i = 0; i < LED_COUNT; i++)
+        {
+            strip.setPixel(i, _pixels[i][0], _pixels[i][1], _pixels[i][2]);
+        }
     }
 
-    strip.show();
+    _frameDirty = true;
 }
 
-void LEDManager::_setColor(unsigned char red, unsigned char green, unsigned char blue)
+bool LEDManager::_setColor(unsigned char red, unsigned char green, unsigned char blue,
+                           unsigned long durationMs, unsigned char easing)
 {
     switch (_transitionType)
     {
     case 1: // fade transition
-        _fadeColor(red, green, blue);
-        break;
     case 2: // chasing transition
-        _colorChase(strip.Color(red, green, blue), 50);
-        break;
+        _startTransition(red, green, blue, _transitionType, durationMs, easing);
+        return true;
     default:
-        return;
+        return false;
     }
-
-    _r = red;
-    _g = green;
-    _b = blue;
 }
 
-void LEDManager::parsePayload(unsigned char *payload, unsigned int msg_length)
+bool LEDManager::handleCommand(JsonDocument& cmdPayload)
 {
-    StaticJsonDocument<128> cmdPayload;
-    deserializeJson(cmdPayload, payload, msg_length);
     byte cmd = cmdPayload["cmd"] | 0;
 
     switch (cmd)
     {
     case 234:
-        _setColor(cmdPayload["data"]["red"] | 255, cmdPayload["data"]["green"] | 255, cmdPayload["data"]["blue"] | 255);
-        break;
+    {
+        unsigned long duration = cmdPayload["data"]["duration"] | _transitionMs;
+        return _setColor(cmdPayload["data"]["red"] | 255, cmdPayload["data"]["green"] | 255, cmdPayload["data"]["blue"] | 255,
+                         min(duration, (unsigned long)LED_MAX_TRANSITION_MS), cmdPayload["data"]["easing"] | _easing);
+    }
     case 236:
         _setBrightness(cmdPayload["data"]["brightness"] | 50);
-        break;
+        return true;
     case 237:
+    {
+        unsigned long duration = cmdPayload["data"]["duration"] | _transitionMs;
         _transitionType = cmdPayload["data"]["transitionType"] | 1;
-        break;
+        _transitionMs = min(duration, (unsigned long)LED_MAX_TRANSITION_MS);
+        _easing = cmdPayload["data"]["easing"] | _easing;
+        return true;
+    }
     default:
-        break;
+        return false;
     }
 }
 
+void LEDManager::renderFrame()
+{
+    if (_transitionActive)
+    {
+        _drawFrame(millis());
+    }
+    else if (!_frameDirty)
+    {
+        return;
+    }
+
+    strip.show();
+    _frameDirty = false;
+}
+
 void LEDManager::setRGBStatus(unsigned char red, unsigned char green, unsigned char blue)
 {
-    _fadeColor(red,green,blue);
-    _r = red;
-    _g = green;
-    _b = blue;
-}
\ No newline at end of file
+    _startTransition(red, green, blue, 1, LED_DEFAULT_TRANSITION_MS, EASE_IN_OUT);
+    _waitForTransition();
+}
@@ -1,29 +1,73 @@
 #ifndef LED_MANAGER_H
 #define LED_MANAGER_H
 
-#include <Adafruit_NeoPixel.h>
 #include <ArduinoJson.h>
+#include "ledStrip.h"
 
 #define LED_PIN    5
 #define LED_COUNT 30
+#define LED_COLOR_ORDER ColorOrder::GRB
+#define LED_DEFAULT_BRIGHTNESS 50
 
+#define LED_FRAME_MS 20
+#define LED_DEFAULT_TRANSITION_MS 500
+#define LED_MAX_TRANSITION_MS 60000
+
+enum LedEasing : unsigned char {
+    EASE_LINEAR = 0,
+    EASE_IN = 1,
+    EASE_OUT = 2,
+    EASE_IN_OUT = 3
+};
 
 class LEDManager{
     public:
         static void begin();
-        static void parsePayload(unsigned char* payload, unsigned int msg_length);
+        // Applies a parsed cmd 234/236/237 payload, returns false if it was ignored
+        static bool handleCommand(JsonDocument& cmdPayload);
         static void setRGBStatus(unsigned char red, unsigned char green, unsigned char blue);
+        // Advances the running transition and pushes pending pixel changes to
+        // the strip (scheduled as a frame task every LED_FRAME_MS)
+        static void renderFrame();
     private:
-        static void _setColor(unsigned char red, unsigned char green, unsigned char blue);
+        static bool _setColor(unsigned char red, unsigned char green, unsigned char blue,
+                              unsigned long durationMs, unsigned char easing);
         static void _setBrightness(unsigned int brightness);
 
-        static void _fadeColor(unsigned char red, unsigned char green, unsigned char blue);
-        static void _colorChase(unsigned int color, int wait);
+        // Starts a transition from the color currently shown to the target,
+        // interrupting any transition still in progress
+        static void _startTransition(unsigned char red, unsigned char green, unsigned char blue,
+                                     unsigned char type, unsigned long durationMs, unsigned char easing);
+        // Renders frames until the running transition ends (setup only)
+        static void _waitForTransition();
+        static void _drawFrame(unsigned long now);
+        static void _showColor(unsigned char red, unsigned char green, unsigned char blue);
+        static void _showPixel(unsigned int index, unsigned char red, unsigned char green, unsigned char blue);
+
+        static unsigned int _ease(unsigned int progress, unsigned char easing);
+        static unsigned char _mix(unsigned char from, unsigned char to, unsigned int progress);
 
+        // Target color
         static unsigned char _r;
         static unsigned char _g;
         static unsigned char _b;
+
+        // Per-pixel colors shown by the last frame and at the transition
+        // start, before brightness scaling
+        static unsigned char _pixels[LED_COUNT][3];
+        static unsigned char _from[LED_COUNT][3];
+        static bool _pixelsUniform;
+        static bool _fromUniform;
+
         static unsigned char _transitionType;
+        static unsigned char _activeType;
+        static unsigned char _easing;
+        static unsigned long _transitionMs;
+        static unsigned long _activeMs;
+        static unsigned char _activeEasing;
+        static unsigned long _transitionStart;
+        static bool _transitionActive;
+        static bool _frameDirty;
 };
 
 #endif
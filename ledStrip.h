@@ -0,0 +1,84 @@
+#ifndef LED_STRIP_H
+#define LED_STRIP_H
+
+#include <Adafruit_NeoPixel.h>
+
+// Wire orders for 3-byte strips, using the Adafruit NEO_xxx encoding so the
+// byte offsets can be decoded at compile time
+enum class ColorOrder : uint8_t {
+    RGB = NEO_RGB,
+    RBG = NEO_RBG,
+    GRB = NEO_GRB,
+    GBR = NEO_GBR,
+    BRG = NEO_BRG,
+    BGR = NEO_BGR
+};
+
+// LED strip whose length, pin and color order are fixed at build time.
+// Pixels are packed straight into the driver buffer in wire order, so the
+// per-pixel bounds checks and color packing of setPixelColor() disappear and
+// the compiler can unroll fixed-length frame fills. Adafruit_NeoPixel is only
+// used for the timing-critical show().
+template <uint16_t PixelCount, uint8_t Pin, ColorOrder Order, uint8_t DefaultBrightness = 255>
+class FixedLedStrip {
+public:
+    static constexpr uint16_t pixelCount = PixelCount;
+    static constexpr size_t frameBytes = (size_t)PixelCount * 3;
+
+    static_assert(PixelCount > 0, "FixedLedStrip needs at least one pixel");
+
+    FixedLedStrip() : _driver(PixelCount, Pin, (neoPixelType)Order + NEO_KHZ800) {}
+
+    void begin() {
+        // The driver brightness is left at its default so show() sends the
+        // buffer untouched; scaling happens here when pixels are written
+        _driver.begin();
+    }
+
+    void show() {
+        _driver.show();
+    }
+
+    // Applies to pixels written after the call, like Adafruit_NeoPixel with a
+    // full frame rewrite
+    void setBrightness(uint8_t brightness) {
+        _scale = (uint16_t)brightness + 1;
+    }
+
+    // index must be below PixelCount, it is not range checked
+    void setPixel(uint16_t index, uint8_t red, uint8_t green, uint8_t blue) {
+        uint8_t* p = _driver.getPixels() + (size_t)index * 3;
+        p[_rOffset] = _scaled(red);
+        p[_gOffset] = _scaled(green);
+        p[_bOffset] = _scaled(blue);
+    }
+
+    // Sets every pixel to the same color, scaling and packing it only once
+    void fill(uint8_t red, uint8_t green, uint8_t blue) {
+        uint8_t packed[3];
+        packed[_rOffset] = _scaled(red);
+        packed[_gOffset] = _scaled(green);
+        packed[_bOffset] = _scaled(blue);
+
+        uint8_t* p = _driver.getPixels();
+        for (uint16_t i = 0; i < PixelCount; i++, p += 3) {
+            p[0] = packed[0];
+            p[1] = packed[1];
+            p[2] = packed[2];
+        }
+    }
+
+private:
+    static constexpr uint8_t _rOffset = ((uint8_t)Order >> 4) & 0b11;
+    static constexpr uint8_t _gOffset = ((uint8_t)Order >> 2) & 0b11;
+    static constexpr uint8_t _bOffset = (uint8_t)Order & 0b11;
+
+    Adafruit_NeoPixel _driver;
+    uint16_t _scale = (uint16_t)DefaultBrightness + 1;
+
+    uint8_t _scaled(uint8_t value) const {
+        return (uint8_t)((value * _scale) >> 8);
+    }
+};
+
+#endif
@@ -8,6 +8,15 @@ MQTTManager::MQTTManager(DeviceConfig& config, MqttCallback callback)
       _mqttClient(_wifiClientSecure), // Initialize PubSubClient with WiFiClientSecure
       _mqttCallback(callback) {
     _instance = this; // Set the static instance pointer
+
+    snprintf(_deviceTopic, sizeof(_deviceTopic), "lightbox/%s/command", _config.mqttClientId);
+
+    _groupTopic[0] = '\0';
+    if (ConfigManager::isValidTopicLevel(_config.mqttGroup)) {
+        snprintf(_groupTopic, sizeof(_groupTopic), "lightbox/group/%s/command", _config.mqttGroup);
+    } else if (strlen(_config.mqttGroup) > 0) {
+        Serial.println("MQTTManager: Ignoring invalid MQTT group, no group topic will be used.");
+    }
 }
 
 void MQTTManager::setupTime(){
@@ -98,13 +107,15 @@ bool MQTTManager::connectMQTT() {
     Serial.print(":");
     Serial.println(_config.mqttPort);
 
-    // Attempt to connect with credentials
+    // Connect without a clean session so the broker keeps our QoS1
+    // subscriptions and queues commands while we are offline
     bool connected;
 
-    connected = _mqttClient.connect(_config.mqttClientId);
+    connected = _mqttClient.connect(_config.mqttClientId, nullptr, nullptr, nullptr, 0, false, nullptr, false);
     
     if (connected) {
         Serial.println("MQTTManager: Connected to MQTT broker.");
+        resubscribe();
         return true;
     } else {
         Serial.print("MQTTManager: MQTT connection failed, rc=");
@@ -157,14 +168,87 @@ bool MQTTManager::publish(const char* topic, const char* payload) {
 }
 
 // Subscribes to a topic
-bool MQTTManager::subscribe(const char* topic) {
+bool MQTTManager::subscribe(const char* topic, uint8_t qos) {
+    bool known = false;
+    for (uint8_t i = 0; i < _subscriptionCount; i++) {
+        if (strcmp(_subscriptions[i], topic) == 0) {
+            _subscriptionQos[i] = qos;
+            known = true;
+            break;
+        }
+    }
+
+    if (!known) {
+        if (_subscriptionCount >= MQTT_MAX_SUBSCRIPTIONS || strlen(topic) >= MQTT_TOPIC_LENGTH) {
+            Serial.print("MQTTManager: Cannot remember subscription: ");
+            Serial.println(topic);
+            return false;
+        }
+        strlcpy(_subscriptions[_subscriptionCount], topic, MQTT_TOPIC_LENGTH);
+        _subscriptionQos[_subscriptionCount] = qos;
+        _subscriptionCount++;
+    }
+
     if (!_mqttClient.connected()) {
-        Serial.println("MQTTManager: Not connected to MQTT broker. Cannot subscribe.");
+        Serial.println("MQTTManager: Not connected to MQTT broker. Will subscribe on connect.");
         return false;
     }
     Serial.print("MQTTManager: Subscribing to topic: ");
     Serial.println(topic);
-    return _mqttClient.subscribe(topic);
+    return _mqttClient.subscribe(topic, qos);
+}
+
+// Subscriptions are renewed on every connect: PubSubClient does not report
+// whether the broker resumed our session, and resubscribing is idempotent
+void MQTTManager::resubscribe() {
+    for (uint8_t i = 0; i < _subscriptionCount; i++) {
+        Serial.print("MQTTManager: Subscribing to topic: ");
+        Serial.println(_subscriptions[i]);
+        _mqttClient.subscribe(_subscriptions[i], _subscriptionQos[i]);
+    }
+}
+
+bool MQTTManager::applyCommandOnce(unsigned long id, std::function<bool()> apply) {
+    if (isDuplicateCommand(id)) {
+        Serial.print("MQTTManager: Ignoring duplicate command ");
+        Serial.println(id);
+        return false;
+    }
+
+    if (!apply()) {
+        return false;
+    }
+
+    recordCommand(id);
+    return true;
+}
+
+bool MQTTManager::isDuplicateCommand(unsigned long id) {
+    if (id == 0) {
+        return false;
+    }
+    for (uint8_t i = 0; i < MQTT_COMMAND_HISTORY; i++) {
+        if (_recentCommandIds[i] == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void MQTTManager::recordCommand(unsigned long id) {
+    if (id == 0) {
+        return;
+    }
+    _recentCommandIds[_recentCommandIndex] = id;
+    _recentCommandIndex = (_recentCommandIndex + 1) % MQTT_COMMAND_HISTORY;
+}
+
+const char* MQTTManager::getDeviceTopic() {
+    return _deviceTopic;
+}
+
+const char* MQTTManager::getGroupTopic() {
+    return _groupTopic;
 }
 
 // Returns true if connected
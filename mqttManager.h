@@ -7,6 +7,15 @@
 #include <PubSubClient.h>     // For MQTT client
 #include "ConfigManager.h"    // To get MQTT credentials from DeviceConfig
 
+#define MQTT_MAX_SUBSCRIPTIONS 4
+#define MQTT_TOPIC_LENGTH 128
+
+// Number of recent command IDs remembered to drop QoS1 redeliveries
+#define MQTT_COMMAND_HISTORY 16
+
+// Fleet-wide topic every device listens on
+#define MQTT_FLEET_COMMAND_TOPIC "lightbox/command"
+
 // Define a callback function type for MQTT messages
 typedef std::function<void(char* topic, byte* payload, unsigned int length)> MqttCallback;
 
@@ -18,7 +27,7 @@ public:
     // Initializes MQTT client with credentials and certificates
     bool begin();
 
-    // Connects to the MQTT broker
+    // Connects to the MQTT broker with a persistent session and restores subscriptions
     bool connectMQTT();
 
     // Handles the MQTT client loop (must be called frequently in main loop)
@@ -27,14 +36,26 @@ public:
     // Publishes a message to an MQTT topic
     bool publish(const char* topic, const char* payload);
 
-    // Subscribes to an MQTT topic
-    bool subscribe(const char* topic);
+    // Subscribes to an MQTT topic; the topic is remembered and resubscribed after every reconnect
+    bool subscribe(const char* topic, uint8_t qos = 1);
+
+    // Per-device command topic: lightbox/<mqttClientId>/command
+    const char* getDeviceTopic();
+
+    // Group command topic: lightbox/group/<mqttGroup>/command, empty if no group is set
+    const char* getGroupTopic();
 
     // Returns true if connected to the MQTT broker
     bool isConnected();
 
     void setupTime();
 
+    // Runs apply() unless a command with this ID was already applied. QoS1 may
+    // redeliver, and one command can arrive on both group and device topics.
+    // The ID is remembered only when apply() accepts the command; 0 means no
+    // ID and is always applied. Returns true if the command was applied.
+    bool applyCommandOnce(unsigned long id, std::function<bool()> apply);
+
 private:
     DeviceConfig& _config;
     WiFiClientSecure _wifiClientSecure;
@@ -45,6 +66,21 @@ private:
     std::unique_ptr<BearSSL::X509List> _clientCert;
     std::unique_ptr<BearSSL::PrivateKey> _privateKey;
     
+    char _deviceTopic[MQTT_TOPIC_LENGTH];
+    char _groupTopic[MQTT_TOPIC_LENGTH];
+
+    char _subscriptions[MQTT_MAX_SUBSCRIPTIONS][MQTT_TOPIC_LENGTH];
+    uint8_t _subscriptionQos[MQTT_MAX_SUBSCRIPTIONS];
+    uint8_t _subscriptionCount = 0;
+
+    void resubscribe();
+
+    bool isDuplicateCommand(unsigned long id);
+    void recordCommand(unsigned long id);
+
+    unsigned long _recentCommandIds[MQTT_COMMAND_HISTORY] = {0};
+    uint8_t _recentCommandIndex = 0;
+
     unsigned long _lastReconnectAttempt = 0;
     const long _reconnectInterval = 5000; // 5 seconds
 
@@ -0,0 +1,129 @@
+#include "taskScheduler.h"
+
+TaskScheduler::TaskScheduler(SchedulerClock clock) : _clock(clock) {}
+
+int TaskScheduler::addTask(const char* name, TaskCallback callback, unsigned long periodMs,
+                           unsigned char priority, unsigned long budgetUs) {
+    return _registerTask(name, callback, periodMs, priority, budgetUs, false);
+}
+
+int TaskScheduler::addDeadlineTask(const char* name, TaskCallback callback, unsigned long periodMs,
+                                   unsigned long budgetUs) {
+    return _registerTask(name, callback, periodMs, 255, budgetUs, true);
+}
+
+int TaskScheduler::_registerTask(const char* name, TaskCallback callback, unsigned long periodMs,
+                                 unsigned char priority, unsigned long budgetUs, bool deadline) {
+    if (_taskCount >= MAX_SCHEDULED_TASKS || callback == nullptr) {
+        Serial.print("TaskScheduler: Cannot register task ");
+        Serial.println(name);
+        return -1;
+    }
+
+    ScheduledTask& task = _tasks[_taskCount];
+    task.name = name;
+    task.callback = callback;
+    task.periodUs = periodMs * 1000UL;
+    task.budgetUs = budgetUs;
+    task.priority = priority;
+    task.deadline = deadline;
+    task.nextRunUs = _clock() + task.periodUs; // First run one period from now
+    task.runs = 0;
+    task.overruns = 0;
+    task.missed = 0;
+    task.maxRunUs = 0;
+
+    return _taskCount++;
+}
+
+int TaskScheduler::_nextDueTask(unsigned long now, const bool* ran) const {
+    int best = -1;
+
+    for (unsigned char i = 0; i < _taskCount; i++) {
+        const ScheduledTask& task = _tasks[i];
+
+        // Signed difference keeps the comparison correct across micros() rollover
+        if (ran[i] || (long)(now - task.nextRunUs) < 0) {
+            continue;
+        }
+
+        if (best < 0) {
+            best = i;
+            continue;
+        }
+
+        const ScheduledTask& current = _tasks[best];
+        if (task.deadline != current.deadline) {
+            if (task.deadline) {
+                best = i;
+            }
+        } else if (task.deadline || task.priority == current.priority) {
+            // Earliest deadline first, also used to break priority ties
+            if ((long)(task.nextRunUs - current.nextRunUs) < 0) {
+                best = i;
+            }
+        } else if (task.priority > current.priority) {
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+void TaskScheduler::run() {
+    bool ran[MAX_SCHEDULED_TASKS] = {false};
+
+    // Re-evaluate after every task so a deadline task that became due
+    // while a slow task was running jumps the queue
+    int id;
+    while ((id = _nextDueTask(_clock(), ran)) >= 0) {
+        ran[id] = true;
+        _runTask(_tasks[id]);
+    }
+}
+
+void TaskScheduler::_runTask(ScheduledTask& task) {
+    unsigned long start = _clock();
+    task.callback();
+    unsigned long elapsed = _clock() - start;
+
+    task.runs++;
+    if (elapsed > task.maxRunUs) {
+        task.maxRunUs = elapsed;
+    }
+    if (task.budgetUs > 0 && elapsed > task.budgetUs) {
+        task.overruns++;
+    }
+
+    task.nextRunUs += task.periodUs;
+
+    unsigned long now = _clock();
+    if ((long)(now - task.nextRunUs) >= 0) {
+        // Fell behind by at least a full period: drop the backlog rather than
+        // running the task back to back
+        if (task.periodUs > 0) {
+            task.missed += (now - task.nextRunUs) / task.periodUs + 1;
+        }
+        task.nextRunUs = now + task.periodUs;
+    }
+}
+
+void TaskScheduler::printNextStats(Print& out) {
+    if (_taskCount == 0) {
+        return;
+    }
+
+    const ScheduledTask& task = _tasks[_statsIndex];
+    _statsIndex = (_statsIndex + 1) % _taskCount;
+
+    out.print("TaskScheduler: ");
+    out.print(task.name);
+    out.print(" runs=");
+    out.print(task.runs);
+    out.print(" overruns=");
+    out.print(task.overruns);
+    out.print(" missed=");
+    out.print(task.missed);
+    out.print(" maxUs=");
+    out.println(task.maxRunUs);
+}
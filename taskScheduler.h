@@ -0,0 +1,65 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+#define MAX_SCHEDULED_TASKS 8
+
+// Plain function pointers keep task registration free of heap allocations
+typedef void (*TaskCallback)();
+
+// Returns the current time in microseconds (micros() on target, a fake clock on host)
+typedef unsigned long (*SchedulerClock)();
+
+struct ScheduledTask {
+    const char* name;
+    TaskCallback callback;
+
+    unsigned long periodUs;
+    unsigned long budgetUs;
+    unsigned char priority;   // Higher value runs first among due tasks
+    bool deadline;            // Deadline tasks always run before priority tasks
+
+    unsigned long nextRunUs;
+
+    unsigned long runs;
+    unsigned long overruns;   // Runs that took longer than budgetUs
+    unsigned long missed;     // Whole periods skipped because the task ran late
+    unsigned long maxRunUs;
+};
+
+class TaskScheduler {
+public:
+    TaskScheduler(SchedulerClock clock = micros);
+
+    // Registers a periodic task, returns its id or -1 if the table is full
+    int addTask(const char* name, TaskCallback callback, unsigned long periodMs,
+                unsigned char priority, unsigned long budgetUs);
+
+    // Registers a task that must hit its period (e.g. LED frame rendering)
+    int addDeadlineTask(const char* name, TaskCallback callback, unsigned long periodMs,
+                        unsigned long budgetUs);
+
+    // Runs every due task once, most urgent first (call from loop())
+    void run();
+
+    // Prints the run/overrun counters of one task per call, cycling through
+    // all tasks, so a report line fits in the UART FIFO without blocking
+    void printNextStats(Print& out);
+
+private:
+    SchedulerClock _clock;
+    ScheduledTask _tasks[MAX_SCHEDULED_TASKS];
+    unsigned char _taskCount = 0;
+    unsigned char _statsIndex = 0;
+
+    int _registerTask(const char* name, TaskCallback callback, unsigned long periodMs,
+                      unsigned char priority, unsigned long budgetUs, bool deadline);
+
+    // Returns the most urgent due task not yet run in this pass, or -1
+    int _nextDueTask(unsigned long now, const bool* ran) const;
+
+    void _runTask(ScheduledTask& task);
+};
+
+#endif
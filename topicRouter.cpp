@@ -0,0 +1,185 @@
+#include "topicRouter.h"
+
+TopicRouter::TopicRouter() {
+    _newNode("", 0); // Root
+}
+
+int16_t TopicRouter::_newNode(const char* level, uint8_t levelLength) {
+    if (_nodeCount >= TOPIC_ROUTER_MAX_NODES || _levelPoolUsed + levelLength > TOPIC_ROUTER_LEVEL_POOL) {
+        return -1;
+    }
+
+    Node& node = _nodes[_nodeCount];
+    memcpy(_levelPool + _levelPoolUsed, level, levelLength);
+    node.level = _levelPoolUsed;
+    node.levelLength = levelLength;
+    node.firstChild = -1;
+    node.nextSibling = -1;
+    node.plusChild = -1;
+    node.hashChild = -1;
+    node.handler = nullptr;
+
+    _levelPoolUsed += levelLength;
+    return _nodeCount++;
+}
+
+void TopicRouter::_rollback(uint16_t nodeCount, uint16_t levelPoolUsed) {
+    // New nodes are appended, so any link to an index >= nodeCount points at
+    // a node being dropped. Only the first new node hangs off an existing
+    // parent, either as a wildcard child or at the head of its sibling list.
+    for (uint16_t i = 0; i < nodeCount; i++) {
+        Node& node = _nodes[i];
+        if (node.firstChild >= (int16_t)nodeCount) {
+            node.firstChild = _nodes[node.firstChild].nextSibling;
+        }
+        if (node.plusChild >= (int16_t)nodeCount) {
+            node.plusChild = -1;
+        }
+        if (node.hashChild >= (int16_t)nodeCount) {
+            node.hashChild = -1;
+        }
+    }
+
+    _nodeCount = nodeCount;
+    _levelPoolUsed = levelPoolUsed;
+}
+
+int16_t TopicRouter::_child(int16_t parent, const char* level, uint8_t levelLength) {
+    if (levelLength == 1 && (level[0] == '+' || level[0] == '#')) {
+        int16_t& wildcard = (level[0] == '+') ? _nodes[parent].plusChild : _nodes[parent].hashChild;
+        if (wildcard < 0) {
+            wildcard = _newNode(level, levelLength);
+        }
+        return wildcard;
+    }
+
+    for (int16_t i = _nodes[parent].firstChild; i >= 0; i = _nodes[i].nextSibling) {
+        if (_nodes[i].levelLength == levelLength && memcmp(_levelPool + _nodes[i].level, level, levelLength) == 0) {
+            return i;
+        }
+    }
+
+    int16_t child = _newNode(level, levelLength);
+    if (child >= 0) {
+        _nodes[child].nextSibling = _nodes[parent].firstChild;
+        _nodes[parent].firstChild = child;
+    }
+    return child;
+}
+
+bool TopicRouter::_isValidFilter(const char* filter) {
+    if (filter == nullptr || filter[0] == '\0') {
+        return false;
+    }
+
+    const char* level = filter;
+    while (level != nullptr) {
+        const char* end = strchr(level, '/');
+        size_t levelLength = end ? (size_t)(end - level) : strlen(level);
+
+        if (levelLength > 255) {
+            return false;
+        }
+
+        // Wildcards must fill a whole level and # must be the last one
+        for (size_t i = 0; i < levelLength; i++) {
+            if ((level[i] == '+' || level[i] == '#') && levelLength != 1) {
+                return false;
+            }
+        }
+        if (levelLength == 1 && level[0] == '#' && end != nullptr) {
+            return false;
+        }
+
+        level = end ? end + 1 : nullptr;
+    }
+    return true;
+}
+
+bool TopicRouter::add(const char* filter, TopicHandler handler) {
+    if (handler == nullptr || !_isValidFilter(filter)) {
+        return false;
+    }
+
+    uint16_t nodeCount = _nodeCount;
+    uint16_t levelPoolUsed = _levelPoolUsed;
+
+    int16_t node = 0;
+    const char* level = filter;
+
+    while (level != nullptr) {
+        const char* end = strchr(level, '/');
+        size_t levelLength = end ? (size_t)(end - level) : strlen(level);
+
+        node = _child(node, level, (uint8_t)levelLength);
+        if (node < 0) {
+            Serial.print("TopicRouter: No room for route ");
+            Serial.println(filter);
+            _rollback(nodeCount, levelPoolUsed);
+            return false;
+        }
+
+        level = end ? end + 1 : nullptr;
+    }
+
+    if (_nodes[node].handler != nullptr) {
+        Serial.print("TopicRouter: Route already registered for ");
+        Serial.println(filter);
+        return false;
+    }
+
+    _nodes[node].handler = handler;
+    return true;
+}
+
+uint8_t TopicRouter::dispatch(char* topic, byte* payload, unsigned int length) const {
+    if (topic == nullptr) {
+        return 0;
+    }
+    return _dispatch(0, topic, topic, payload, length);
+}
+
+uint8_t TopicRouter::_dispatch(int16_t node, const char* level, char* topic, byte* payload, unsigned int length) const {
+    const Node& current = _nodes[node];
+    uint8_t matched = 0;
+
+    if (level == nullptr) {
+        if (current.handler != nullptr) {
+            current.handler(topic, payload, length);
+            matched++;
+        }
+        // "a/#" also matches "a"
+        if (current.hashChild >= 0 && _nodes[current.hashChild].handler != nullptr) {
+            _nodes[current.hashChild].handler(topic, payload, length);
+            matched++;
+        }
+        return matched;
+    }
+
+    const char* end = strchr(level, '/');
+    size_t levelLength = end ? (size_t)(end - level) : strlen(level);
+    const char* next = end ? end + 1 : nullptr;
+
+    for (int16_t i = current.firstChild; i >= 0; i = _nodes[i].nextSibling) {
+        if (_nodes[i].levelLength == levelLength && memcmp(_levelPool + _nodes[i].level, level, levelLength) == 0) {
+            matched += _dispatch(i, next, topic, payload, length);
+            break;
+        }
+    }
+
+    // Wildcards at the first level never match $-prefixed system topics
+    if (node == 0 && level[0] == '$') {
+        return matched;
+    }
+
+    if (current.plusChild >= 0) {
+        matched += _dispatch(current.plusChild, next, topic, payload, length);
+    }
+
+    if (current.hashChild >= 0 && _nodes[current.hashChild].handler != nullptr) {
+        _nodes[current.hashChild].handler(topic, payload, length);
+        matched++;
+    }
+
+    return matched;
+}
@@ -0,0 +1,62 @@
+#ifndef TOPIC_ROUTER_H
+#define TOPIC_ROUTER_H
+
+#include <Arduino.h>
+
+// A route adds one node for every level not shared with an earlier filter.
+// Routes like "lightbox/<id>/cmd" add two nodes each, so about 60 fit in 128
+// nodes. Three-level filters that share nothing fit about 40. The level pool
+// holds the level text, 12 bytes per node on average. Together ~3.5 KB of RAM.
+#define TOPIC_ROUTER_MAX_NODES 128
+#define TOPIC_ROUTER_LEVEL_POOL 1536
+
+typedef void (*TopicHandler)(char* topic, byte* payload, unsigned int length);
+
+// Routes incoming MQTT messages to handlers by topic filter. Filters are
+// compiled into a trie of topic levels held in fixed pools, so neither
+// registering a route nor dispatching a message touches the heap. Supports
+// the MQTT single-level (+) and multi-level (#) wildcards.
+class TopicRouter {
+public:
+    TopicRouter();
+
+    // Registers a handler for a topic filter, e.g. "lightbox/+/command" or
+    // "lightbox/ota/#". Returns false if the filter is invalid, already
+    // routed, or the pools are full.
+    bool add(const char* filter, TopicHandler handler);
+
+    // Calls every handler whose filter matches the topic, returns how many ran
+    uint8_t dispatch(char* topic, byte* payload, unsigned int length) const;
+
+private:
+    struct Node {
+        uint16_t level;      // Offset of the level text in _levelPool
+        uint8_t levelLength;
+        int16_t firstChild;  // Literal children, linked through nextSibling
+        int16_t nextSibling;
+        int16_t plusChild;
+        int16_t hashChild;
+        TopicHandler handler;
+    };
+
+    Node _nodes[TOPIC_ROUTER_MAX_NODES];
+    uint16_t _nodeCount = 0;
+
+    char _levelPool[TOPIC_ROUTER_LEVEL_POOL];
+    uint16_t _levelPoolUsed = 0;
+
+    static bool _isValidFilter(const char* filter);
+
+    // Drops nodes created after a failed add() and unlinks them from their parent
+    void _rollback(uint16_t nodeCount, uint16_t levelPoolUsed);
+
+    int16_t _newNode(const char* level, uint8_t levelLength);
+
+    // Returns the child matching the level, creating it if needed (-1 when full)
+    int16_t _child(int16_t parent, const char* level, uint8_t levelLength);
+
+    // level points at the current topic level, or is nullptr once the topic is consumed
+    uint8_t _dispatch(int16_t node, const char* level, char* topic, byte* payload, unsigned int length) const;
+};
+
+#endif
@@ -22,6 +22,13 @@ void WebServerHandler::handleRoot() {
 
 void WebServerHandler::handleSaveConfig() {
 
+    // The group becomes an MQTT topic level, so separators and wildcards are rejected
+    if (_server.hasArg("mqttGroup") && _server.arg("mqttGroup").length() > 0 &&
+        !ConfigManager::isValidTopicLevel(_server.arg("mqttGroup").c_str())) {
+        _server.send(400, "text/plain", "Invalid mqttGroup: must not contain '/', '+' or '#'.");
+        return;
+    }
+
     if (_server.hasArg("wifiSsid")) {
         strlcpy(_config.wifiSsid, _server.arg("wifiSsid").c_str(), sizeof(_config.wifiSsid));
     }
@@ -36,6 +43,10 @@ void WebServerHandler::handleSaveConfig() {
         _config.mqttPort = _server.arg("mqttPort").toInt();
     }
 
+    if(_server.hasArg("mqttGroup") && _server.arg("mqttGroup").length() > 0){
+        strlcpy(_config.mqttGroup, _server.arg("mqttGroup").c_str(), sizeof(_config.mqttGroup));
+    }
+
     if(_server.hasArg("mqttCaCert")){
         strlcpy(_config.mqttCaCert, _server.arg("mqttCaCert").c_str(), sizeof(_config.mqttCaCert));
     } 